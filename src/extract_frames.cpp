@@ -0,0 +1,241 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include "frame_extractor.hpp"
+
+// Herramienta de línea de comandos para frame-extractor.
+//   extract-frames <video> [batch] [stride]   extrae el video completo e informa del rendimiento
+//   extract-frames --check <video>            verifica layout, orden de canales y muestreo
+
+using namespace std;
+
+static const float IMAGENET_MEAN[3] = { 0.485f, 0.456f, 0.406f };
+static const float IMAGENET_STD[3] = { 0.229f, 0.224f, 0.225f };
+
+// Lee el primer lote del video con la configuración indicada. Devuelve el número de frames.
+static int read_first_batch(const char* filename, const ExtractorConfig& config, vector<uint8_t>& data, vector<double>& pts) {
+    FrameExtractor ex;
+    if (!frame_extractor_open(&ex, filename, config)) {
+        return -1;
+    }
+    data.assign(frame_extractor_batch_bytes(config), 0);
+    pts.assign(config.batch_size, 0.0);
+    int count = frame_extractor_read_batch(&ex, data.data(), pts.data());
+    frame_extractor_close(&ex);
+    return count;
+}
+
+static int64_t count_frames(const char* filename, ExtractorConfig config) {
+    FrameExtractor ex;
+    if (!frame_extractor_open(&ex, filename, config)) {
+        return -1;
+    }
+    vector<uint8_t> data(frame_extractor_batch_bytes(config));
+    int64_t total = 0;
+    while (int n = frame_extractor_read_batch(&ex, data.data(), nullptr)) {
+        total += n;
+    }
+    frame_extractor_close(&ex);
+    return total;
+}
+
+static bool report(const char* name, bool ok) {
+    cout << (ok ? "OK   " : "FAIL ") << name << endl;
+    return ok;
+}
+
+static int run_checks(const char* filename) {
+    const int batch = 4;
+    const int stride = 3;
+    ExtractorConfig base;
+    base.out_width = 64;
+    base.out_height = 48;
+    const size_t plane = (size_t)base.out_width * base.out_height;
+    const size_t frame_elems = plane * 3;
+
+    // Referencia: UINT8 NHWC, RGB24 tal cual lo produce swscale
+    ExtractorConfig ref_config = base;
+    ref_config.type = TensorType::UINT8;
+    ref_config.layout = TensorLayout::NHWC;
+    ref_config.batch_size = batch * stride;
+    vector<uint8_t> ref;
+    vector<double> ref_pts;
+    int ref_count = read_first_batch(filename, ref_config, ref, ref_pts);
+    if (ref_count < batch * stride) {
+        cout << "Clip too short or unreadable: need at least " << batch * stride << " frames" << endl;
+        return 1;
+    }
+
+    bool ok = true;
+    double channel_spread = 0.0;
+    for (size_t i = 0; i < frame_elems; i += 3) {
+        channel_spread += abs(ref[i] - ref[i + 1]) + abs(ref[i + 1] - ref[i + 2]);
+    }
+    if (channel_spread / plane < 1.0) {
+        cout << "Warning: clip is nearly grayscale, channel order is not really verified" << endl;
+    }
+
+    // UINT8 NCHW: planos GBRP reordenados a R, G, B
+    ExtractorConfig u8_nchw = base;
+    u8_nchw.type = TensorType::UINT8;
+    u8_nchw.layout = TensorLayout::NCHW;
+    u8_nchw.batch_size = batch;
+    vector<uint8_t> data;
+    vector<double> pts;
+    int max_diff = 0;
+    read_first_batch(filename, u8_nchw, data, pts);
+    for (int n = 0; n < batch; n++) {
+        for (size_t p = 0; p < plane; p++) {
+            for (int c = 0; c < 3; c++) {
+                int a = ref[n * frame_elems + p * 3 + c];
+                int b = data[n * frame_elems + c * plane + p];
+                max_diff = max(max_diff, abs(a - b));
+            }
+        }
+    }
+    // GBRP y RGB24 siguen caminos distintos en swscale: se admite error de redondeo
+    ok &= report("uint8 NCHW matches NHWC reference", max_diff <= 2);
+
+    // FLOAT32 NHWC sin normalización: pixel / 255
+    ExtractorConfig f32_nhwc = base;
+    f32_nhwc.layout = TensorLayout::NHWC;
+    f32_nhwc.batch_size = batch;
+    read_first_batch(filename, f32_nhwc, data, pts);
+    const float* values = (const float*)data.data();
+    double max_error = 0.0;
+    for (size_t i = 0; i < batch * frame_elems; i++) {
+        max_error = max(max_error, (double)fabs(values[i] - ref[i] / 255.0f));
+    }
+    ok &= report("float32 NHWC equals pixel / 255", max_error < 1e-6);
+
+    // FLOAT32 NCHW con mean/std de ImageNet
+    ExtractorConfig f32_nchw = base;
+    f32_nchw.batch_size = batch;
+    memcpy(f32_nchw.mean, IMAGENET_MEAN, sizeof(IMAGENET_MEAN));
+    memcpy(f32_nchw.stddev, IMAGENET_STD, sizeof(IMAGENET_STD));
+    vector<uint8_t> nchw_data;
+    read_first_batch(filename, f32_nchw, nchw_data, pts);
+    values = (const float*)nchw_data.data();
+    max_error = 0.0;
+    for (int n = 0; n < batch; n++) {
+        for (size_t p = 0; p < plane; p++) {
+            for (int c = 0; c < 3; c++) {
+                float expected = (ref[n * frame_elems + p * 3 + c] / 255.0f - IMAGENET_MEAN[c]) / IMAGENET_STD[c];
+                max_error = max(max_error, (double)fabs(values[n * frame_elems + c * plane + p] - expected));
+            }
+        }
+    }
+    ok &= report("float32 NCHW normalized with mean/std", max_error < 1e-5);
+
+    // UINT8 con mean/std no está soportado
+    ExtractorConfig u8_normalized = u8_nchw;
+    memcpy(u8_normalized.mean, IMAGENET_MEAN, sizeof(IMAGENET_MEAN));
+    FrameExtractor rejected;
+    ok &= report("uint8 with mean/std is rejected", !frame_extractor_open(&rejected, filename, u8_normalized));
+
+    // frame_stride: frames 0, stride, 2 * stride...
+    ExtractorConfig strided = ref_config;
+    strided.batch_size = batch;
+    strided.frame_stride = stride;
+    read_first_batch(filename, strided, data, pts);
+    bool stride_ok = true;
+    for (int n = 0; n < batch; n++) {
+        stride_ok &= pts[n] == ref_pts[n * stride];
+        stride_ok &= memcmp(&data[n * frame_elems], &ref[n * stride * frame_elems], frame_elems) == 0;
+    }
+    ok &= report("frame_stride samples every Nth frame", stride_ok);
+
+    // frame_extractor_run: mismos frames que la lectura secuencial y estadísticas coherentes
+    ExtractorConfig threaded = f32_nchw;
+    threaded.num_threads = 2;
+    int64_t expected_frames = count_frames(filename, threaded);
+    FrameExtractor ex;
+    ExtractorStats stats;
+    mutex buffers_mutex;
+    vector<vector<uint8_t>> buffers;
+    vector<bool> seen;
+    bool run_ok = frame_extractor_open(&ex, filename, threaded);
+    if (run_ok) {
+        run_ok = frame_extractor_run(&ex,
+            [&](int index) -> void* {
+                lock_guard<mutex> lock(buffers_mutex);
+                if ((int)buffers.size() <= index) buffers.resize(index + 1);
+                buffers[index].resize(frame_extractor_batch_bytes(threaded));
+                return buffers[index].data();
+            },
+            [&](const TensorBatch& b) {
+                lock_guard<mutex> lock(buffers_mutex);
+                if ((int)seen.size() <= b.index) seen.resize(b.index + 1, false);
+                seen[b.index] = true;
+            },
+            &stats);
+        frame_extractor_close(&ex);
+    }
+    bool all_seen = !seen.empty();
+    for (bool s : seen) all_seen &= s;
+    ok &= report("frame_extractor_run delivers every batch", run_ok && all_seen && stats.batches == (int64_t)seen.size());
+    ok &= report("frame_extractor_run frame count", stats.frames == expected_frames);
+    ok &= report("frame_extractor_run byte count", stats.bytes == stats.frames * (int64_t)frame_extractor_frame_bytes(threaded));
+    ok &= report("frame_extractor_run throughput", stats.frames_per_second() > 0.0 && stats.gigabytes_per_second() > 0.0);
+    if (run_ok && expected_frames > 0) {
+        ok &= report("frame_extractor_run first batch matches read_batch",
+            memcmp(buffers[0].data(), nchw_data.data(), nchw_data.size()) == 0);
+    }
+
+    return ok ? 0 : 1;
+}
+
+int main(int argc, const char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "--check") == 0) {
+        return run_checks(argv[2]);
+    }
+    if (argc < 2 || argv[1][0] == '-') {
+        cout << "Usage: extract-frames <video> [batch] [stride] | extract-frames --check <video>" << endl;
+        return 1;
+    }
+
+    ExtractorConfig config;
+    config.batch_size = argc >= 3 ? atoi(argv[2]) : 8;
+    config.frame_stride = argc >= 4 ? atoi(argv[3]) : 1;
+    memcpy(config.mean, IMAGENET_MEAN, sizeof(IMAGENET_MEAN));
+    memcpy(config.stddev, IMAGENET_STD, sizeof(IMAGENET_STD));
+
+    FrameExtractor ex;
+    if (!frame_extractor_open(&ex, argv[1], config)) {
+        return 1;
+    }
+
+    // Un buffer por hilo de trabajo, reutilizado entre lotes
+    mutex buffers_mutex;
+    vector<uint8_t*> free_buffers;
+    vector<uint8_t*> all_buffers;
+    ExtractorStats stats;
+    bool ok = frame_extractor_run(&ex,
+        [&](int) -> void* {
+            lock_guard<mutex> lock(buffers_mutex);
+            if (free_buffers.empty()) {
+                all_buffers.push_back(new uint8_t[frame_extractor_batch_bytes(config)]);
+                free_buffers.push_back(all_buffers.back());
+            }
+            uint8_t* buffer = free_buffers.back();
+            free_buffers.pop_back();
+            return buffer;
+        },
+        [&](const TensorBatch& batch) {
+            lock_guard<mutex> lock(buffers_mutex);
+            free_buffers.push_back((uint8_t*)batch.data);
+        },
+        &stats);
+    frame_extractor_close(&ex);
+    for (uint8_t* buffer : all_buffers) {
+        delete[] buffer;
+    }
+
+    cout << "Extracted " << stats.frames << " frames in " << stats.batches << " batches: "
+         << stats.frames_per_second() << " frames/s, "
+         << stats.gigabytes_per_second() << " GB/s" << endl;
+    return ok ? 0 : 1;
+}
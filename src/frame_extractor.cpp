@@ -0,0 +1,377 @@
+#include "frame_extractor.hpp"
+#include "safe_queue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+using namespace std;
+
+struct BatchJob {
+    int index;
+    vector<AVFrame*> frames;
+};
+
+// Hilos de conversión: la conversión es más barata que la decodificación, así que
+// por defecto se usa como mucho la mitad de los núcleos (máximo 4).
+static int extractor_worker_count(const ExtractorConfig& config) {
+    if (config.num_threads > 0) {
+        return config.num_threads;
+    }
+    int cores = max(1, (int)thread::hardware_concurrency());
+    return max(1, min(4, cores / 2));
+}
+
+static void build_normalization_tables(FrameExtractor* ex) {
+    const ExtractorConfig& config = ex->config;
+    for (int c = 0; c < 3; c++) {
+        for (int v = 0; v < 256; v++) {
+            float value = (v * config.scale - config.mean[c]) / config.stddev[c];
+            ex->lut_f32[c][v] = value;
+        }
+    }
+}
+
+void frame_extractor_close(FrameExtractor* ex) {
+    sws_freeContext(ex->sws_context);
+    ex->sws_context = nullptr;
+    av_frame_free(&ex->av_frame);
+    av_packet_free(&ex->av_packet);
+    avcodec_free_context(&ex->video_codec_context);
+    avformat_close_input(&ex->format_context);
+}
+
+bool frame_extractor_open(FrameExtractor* ex, const char* filename, const ExtractorConfig& config) {
+    auto& format_context = ex->format_context;
+    auto& video_codec_context = ex->video_codec_context;
+    auto& video_stream_index = ex->video_stream_index;
+
+    if (config.batch_size <= 0 || config.out_width <= 0 || config.out_height <= 0 || config.frame_stride <= 0) {
+        cout << "Invalid extractor configuration" << endl;
+        return false;
+    }
+    for (int c = 0; c < 3; c++) {
+        if (config.stddev[c] == 0.0f) {
+            cout << "Invalid extractor configuration: stddev must be non-zero" << endl;
+            return false;
+        }
+        // Un tensor UINT8 no puede representar valores normalizados (negativos o fraccionarios)
+        if (config.type == TensorType::UINT8 && (config.mean[c] != 0.0f || config.stddev[c] != 1.0f)) {
+            cout << "Invalid extractor configuration: UINT8 output doesn't support mean/stddev normalization" << endl;
+            return false;
+        }
+    }
+    ex->config = config;
+    ex->decoded_frames = 0;
+    ex->flushing = false;
+
+    // Abrir el archivo usando avformat
+    if (avformat_open_input(&format_context, filename, NULL, NULL) != 0) {
+        cout << "Couldn't open video file" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+    if (avformat_find_stream_info(format_context, NULL) < 0) {
+        cout << "Couldn't read stream info" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+
+    // Solo interesa el flujo de video: descartar el resto de paquetes en el demuxer
+    video_stream_index = av_find_best_stream(format_context, AVMEDIA_TYPE_VIDEO, -1, -1, NULL, 0);
+    if (video_stream_index < 0) {
+        cout << "Couldn't find video stream" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+    for (unsigned int i = 0; i < format_context->nb_streams; i++) {
+        if ((int)i != video_stream_index) {
+            format_context->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    AVStream* stream = format_context->streams[video_stream_index];
+    const AVCodec* video_codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!video_codec) {
+        cout << "Couldn't find video decoder" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+    ex->width = stream->codecpar->width;
+    ex->height = stream->codecpar->height;
+    ex->video_time_base = stream->time_base;
+
+    // Configurar el contexto del códec de video
+    video_codec_context = avcodec_alloc_context3(video_codec);
+    if (!video_codec_context) {
+        cout << "Couldn't create video codec context" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+    if (avcodec_parameters_to_context(video_codec_context, stream->codecpar) < 0) {
+        cout << "Couldn't initialize video codec context" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+    // La decodificación es secuencial: dar al decodificador los núcleos que no usa la conversión
+    int cores = max(1, (int)thread::hardware_concurrency());
+    video_codec_context->thread_count = max(1, cores - extractor_worker_count(config));
+    if (avcodec_open2(video_codec_context, video_codec, nullptr) < 0) {
+        cout << "Couldn't open video codec" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+
+    ex->av_packet = av_packet_alloc();
+    ex->av_frame = av_frame_alloc();
+    if (!ex->av_packet || !ex->av_frame) {
+        cout << "Couldn't allocate memory for AV frame or AV packet" << endl;
+        frame_extractor_close(ex);
+        return false;
+    }
+
+    build_normalization_tables(ex);
+    return true;
+}
+
+size_t frame_extractor_frame_bytes(const ExtractorConfig& config) {
+    size_t element_size = config.type == TensorType::FLOAT32 ? sizeof(float) : sizeof(uint8_t);
+    return (size_t)config.out_width * config.out_height * 3 * element_size;
+}
+
+size_t frame_extractor_batch_bytes(const ExtractorConfig& config) {
+    return frame_extractor_frame_bytes(config) * config.batch_size;
+}
+
+// Obtiene el siguiente frame aplicando frame_stride. Devuelve false al final del stream.
+static bool decode_next_frame(FrameExtractor* ex, AVFrame* frame) {
+    while (true) {
+        int response = avcodec_receive_frame(ex->video_codec_context, frame);
+        if (response >= 0) {
+            bool keep = ex->decoded_frames % ex->config.frame_stride == 0;
+            ex->decoded_frames++;
+            if (keep) {
+                return true;
+            }
+            av_frame_unref(frame);
+            continue;
+        }
+        if (response != AVERROR(EAGAIN) || ex->flushing) {
+            return false;
+        }
+
+        // El decodificador necesita más datos
+        response = av_read_frame(ex->format_context, ex->av_packet);
+        if (response < 0) {
+            // Fin del archivo: vaciar los frames retenidos por el decodificador
+            ex->flushing = true;
+            avcodec_send_packet(ex->video_codec_context, nullptr);
+            continue;
+        }
+        if (ex->av_packet->stream_index == ex->video_stream_index) {
+            avcodec_send_packet(ex->video_codec_context, ex->av_packet);
+        }
+        av_packet_unref(ex->av_packet);
+    }
+}
+
+// best_effort_timestamp corrige PTS ausentes o desordenados de algunos contenedores
+static double frame_pts_seconds(const FrameExtractor* ex, const AVFrame* frame) {
+    int64_t pts = (frame->best_effort_timestamp != AV_NOPTS_VALUE) ? frame->best_effort_timestamp : frame->pts;
+    if (pts == AV_NOPTS_VALUE) {
+        return NAN;
+    }
+    return pts * av_q2d(ex->video_time_base);
+}
+
+// Escala un frame y lo escribe normalizado en dst (inicio del frame dentro del lote).
+static bool convert_frame(const FrameExtractor* ex, SwsContext** sws, vector<uint8_t>& scratch, const AVFrame* frame, uint8_t* dst) {
+    const ExtractorConfig& config = ex->config;
+    const int out_w = config.out_width;
+    const int out_h = config.out_height;
+    const size_t plane = (size_t)out_w * out_h;
+
+    // En UINT8 (sin normalización) swscale escribe directamente en el tensor:
+    // RGB24 empaquetado para NHWC y GBRP planar (planos reordenados) para NCHW.
+    bool direct = config.type == TensorType::UINT8;
+    AVPixelFormat dst_format = (direct && config.layout == TensorLayout::NCHW) ? AV_PIX_FMT_GBRP : AV_PIX_FMT_RGB24;
+
+    // sws_getCachedContext solo reinicializa el escalador si cambian las dimensiones
+    *sws = sws_getCachedContext(
+        *sws,
+        frame->width,
+        frame->height,
+        (AVPixelFormat)frame->format,
+        out_w,
+        out_h,
+        dst_format,
+        SWS_BILINEAR,
+        nullptr, nullptr, nullptr
+    );
+    if (!*sws) {
+        cout << "Couldn't initialize SW scaler" << endl;
+        return false;
+    }
+
+    uint8_t* dest[4] = { nullptr, nullptr, nullptr, nullptr };
+    int dest_linesize[4] = { 0, 0, 0, 0 };
+    if (direct && config.layout == TensorLayout::NCHW) {
+        dest[0] = dst + plane;      // G
+        dest[1] = dst + 2 * plane;  // B
+        dest[2] = dst;              // R
+        dest_linesize[0] = dest_linesize[1] = dest_linesize[2] = out_w;
+    } else {
+        scratch.resize(plane * 3);
+        dest[0] = direct ? dst : scratch.data();
+        dest_linesize[0] = out_w * 3;
+    }
+
+    int result = sws_scale(*sws, frame->data, frame->linesize, 0, frame->height, dest, dest_linesize);
+    if (result <= 0) {
+        cout << "sws_scale failed with error code: " << result << endl;
+        return false;
+    }
+    if (direct) {
+        return true;
+    }
+
+    // Normalizar desde RGB24 con las tablas precalculadas
+    const uint8_t* src = scratch.data();
+    float* out = (float*)dst;
+    if (config.layout == TensorLayout::NHWC) {
+        for (size_t i = 0; i < plane; i++, src += 3, out += 3) {
+            out[0] = ex->lut_f32[0][src[0]];
+            out[1] = ex->lut_f32[1][src[1]];
+            out[2] = ex->lut_f32[2][src[2]];
+        }
+    } else {
+        float* r = out;
+        float* g = out + plane;
+        float* b = out + 2 * plane;
+        for (size_t i = 0; i < plane; i++, src += 3) {
+            r[i] = ex->lut_f32[0][src[0]];
+            g[i] = ex->lut_f32[1][src[1]];
+            b[i] = ex->lut_f32[2][src[2]];
+        }
+    }
+    return true;
+}
+
+int frame_extractor_read_batch(FrameExtractor* ex, void* dst, double* pts) {
+    const size_t frame_bytes = frame_extractor_frame_bytes(ex->config);
+    uint8_t* out = (uint8_t*)dst;
+    int count = 0;
+    while (count < ex->config.batch_size && decode_next_frame(ex, ex->av_frame)) {
+        if (convert_frame(ex, &ex->sws_context, ex->scratch, ex->av_frame, out + count * frame_bytes)) {
+            if (pts) {
+                pts[count] = frame_pts_seconds(ex, ex->av_frame);
+            }
+            count++;
+        }
+        av_frame_unref(ex->av_frame);
+    }
+    return count;
+}
+
+static void free_batch_job(BatchJob* job) {
+    for (AVFrame*& frame : job->frames) {
+        av_frame_free(&frame);
+    }
+    delete job;
+}
+
+bool frame_extractor_run(FrameExtractor* ex, const BatchAcquireFn& acquire, const BatchReadyFn& ready, ExtractorStats* stats) {
+    const size_t frame_bytes = frame_extractor_frame_bytes(ex->config);
+
+    // Lotes retenidos a la vez: los de la cola, uno por hilo de trabajo y el que
+    // está llenando el decodificador. Todos juntos no superan max_queued_frames.
+    int budget_jobs = ex->config.max_queued_frames / ex->config.batch_size;
+    if (budget_jobs < 3) {
+        cout << "Invalid extractor configuration: max_queued_frames must hold at least 3 batches" << endl;
+        return false;
+    }
+    int num_threads = min(extractor_worker_count(ex->config), budget_jobs - 2);
+    SafeQueue<BatchJob*> job_queue(budget_jobs - 1 - num_threads);
+    atomic<int64_t> frames(0);
+    atomic<int64_t> batches(0);
+    atomic<bool> failed(false);
+
+    using Clock = chrono::steady_clock;
+    Clock::time_point start_time = Clock::now();
+
+    vector<thread> workers;
+    for (int t = 0; t < num_threads; t++) {
+        workers.emplace_back([&]() {
+            SwsContext* sws = nullptr;
+            vector<uint8_t> scratch;
+            BatchJob* job;
+            while (true) {
+                job_queue.wait_dequeue(job);
+                if (!job) break;
+
+                TensorBatch batch;
+                batch.index = job->index;
+                batch.count = 0;
+                batch.data = acquire(job->index);
+                if (batch.data) {
+                    uint8_t* out = (uint8_t*)batch.data;
+                    for (AVFrame* frame : job->frames) {
+                        if (!convert_frame(ex, &sws, scratch, frame, out + batch.count * frame_bytes)) {
+                            failed = true;
+                            continue;
+                        }
+                        batch.pts.push_back(frame_pts_seconds(ex, frame));
+                        batch.count++;
+                    }
+                    ready(batch);
+                    frames += batch.count;
+                    batches++;
+                }
+                free_batch_job(job);
+            }
+            sws_freeContext(sws);
+        });
+    }
+
+    // Decodificar en el hilo actual y repartir los lotes
+    int batch_index = 0;
+    bool end_of_stream = false;
+    while (!end_of_stream) {
+        BatchJob* job = new BatchJob();
+        job->index = batch_index;
+        while ((int)job->frames.size() < ex->config.batch_size) {
+            AVFrame* frame = av_frame_alloc();
+            if (!frame || !decode_next_frame(ex, frame)) {
+                av_frame_free(&frame);
+                end_of_stream = true;
+                break;
+            }
+            job->frames.push_back(frame);
+        }
+        if (job->frames.empty()) {
+            free_batch_job(job);
+            break;
+        }
+        job_queue.enqueue(job);
+        batch_index++;
+    }
+
+    // Un centinela por hilo
+    for (int t = 0; t < num_threads; t++) {
+        job_queue.enqueue(nullptr);
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    chrono::duration<double> elapsed_seconds = Clock::now() - start_time;
+    if (stats) {
+        stats->frames = frames;
+        stats->batches = batches;
+        stats->bytes = frames * (int64_t)frame_bytes;
+        stats->seconds = elapsed_seconds.count();
+    }
+    return !failed;
+}
@@ -0,0 +1,114 @@
+#ifndef frame_extractor_hpp
+#define frame_extractor_hpp
+
+#include <functional>
+#include <vector>
+extern "C" {
+    #include <libavcodec/avcodec.h>
+    #include <libavformat/avformat.h>
+    #include <libavutil/avutil.h>
+    #include <libswscale/swscale.h>
+    #include <inttypes.h>
+}
+
+using namespace std;
+
+// Extracción de frames en lotes para inferencia, independiente de SDL/OpenGL.
+// Cada lote se escribe directamente en un buffer contiguo del llamador con
+// forma [N, C, H, W] (NCHW) o [N, H, W, C] (NHWC), canales en orden RGB.
+
+enum class TensorLayout {
+    NCHW,
+    NHWC
+};
+
+enum class TensorType {
+    FLOAT32,
+    UINT8
+};
+
+struct ExtractorConfig {
+    int batch_size = 8;
+    int out_width = 224;
+    int out_height = 224;
+    TensorLayout layout = TensorLayout::NCHW;
+    TensorType type = TensorType::FLOAT32;
+
+    // Normalización por canal en FLOAT32: out = (pixel * scale - mean) / stddev.
+    // UINT8 guarda los píxeles sin normalizar y exige mean = 0 y stddev = 1.
+    float scale = 1.0f / 255.0f;
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    float stddev[3] = { 1.0f, 1.0f, 1.0f };
+
+    int frame_stride = 1;  // Quedarse con uno de cada N frames decodificados
+    int num_threads = 0;   // Hilos de conversión en frame_extractor_run (0 = automático)
+    // Máximo de frames decodificados retenidos por frame_extractor_run (en cola, en conversión
+    // y en el lote que se está decodificando). Debe cubrir al menos 3 lotes; si no alcanza
+    // para num_threads + 2 lotes se usan menos hilos de conversión.
+    int max_queued_frames = 64;
+};
+
+struct ExtractorStats {
+    int64_t frames = 0;
+    int64_t batches = 0;
+    int64_t bytes = 0;
+    double seconds = 0.0;
+
+    double frames_per_second() const { return seconds > 0.0 ? frames / seconds : 0.0; }
+    double gigabytes_per_second() const { return seconds > 0.0 ? bytes / seconds / 1e9 : 0.0; }
+};
+
+struct TensorBatch {
+    void* data = nullptr;   // Buffer del llamador, frame_extractor_batch_bytes() bytes
+    int index;              // Número de lote en orden de decodificación
+    int count;              // Frames válidos (el último lote puede ir incompleto)
+    vector<double> pts;     // PTS en segundos de cada frame (NAN si el stream no tiene marca de tiempo)
+};
+
+// Devuelve el buffer donde escribir el lote indicado (nullptr lo descarta).
+typedef function<void*(int batch_index)> BatchAcquireFn;
+// Se llama cuando el lote está completo. Los lotes pueden llegar desordenados.
+typedef function<void(const TensorBatch& batch)> BatchReadyFn;
+
+struct FrameExtractor {
+    ExtractorConfig config;
+    int width;
+    int height;
+    AVRational video_time_base;
+    AVFormatContext* format_context = nullptr;
+    AVCodecContext* video_codec_context = nullptr;
+    SwsContext* sws_context = nullptr;
+    AVPacket* av_packet = nullptr;
+    AVFrame* av_frame = nullptr;
+    int video_stream_index;
+
+    int64_t decoded_frames = 0;  // Contador para el muestreo con frame_stride
+    bool flushing = false;
+
+    // Tabla de normalización precalculada por canal (FLOAT32)
+    float lut_f32[3][256];
+    vector<uint8_t> scratch;  // RGB24 intermedio para frame_extractor_read_batch
+
+    FrameExtractor() {}
+
+    // Deshabilitar la copia de FrameExtractor
+    FrameExtractor(const FrameExtractor&) = delete;
+    FrameExtractor& operator=(const FrameExtractor&) = delete;
+};
+
+bool frame_extractor_open(FrameExtractor* ex, const char* filename, const ExtractorConfig& config);
+void frame_extractor_close(FrameExtractor* ex);
+
+size_t frame_extractor_frame_bytes(const ExtractorConfig& config);
+size_t frame_extractor_batch_bytes(const ExtractorConfig& config);
+
+// Decodifica y convierte el siguiente lote en el hilo actual.
+// Devuelve el número de frames escritos (0 al final del stream). pts puede ser nullptr;
+// un frame sin marca de tiempo recibe NAN.
+int frame_extractor_read_batch(FrameExtractor* ex, void* dst, double* pts);
+
+// Decodifica el stream completo y reparte la conversión de los lotes entre varios hilos.
+// acquire y ready se llaman desde los hilos de trabajo y deben ser thread-safe.
+bool frame_extractor_run(FrameExtractor* ex, const BatchAcquireFn& acquire, const BatchReadyFn& ready, ExtractorStats* stats);
+
+#endif
@@ -0,0 +1,255 @@
+#include "frame_scheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+using namespace std;
+
+#define SYNC_GAIN 0.1          // Fracción de la deriva corregida en cada refresco
+#define DUE_EPSILON 1e-6       // Desempate estable cuando el PTS cae justo en la frontera
+
+void vsync_clock_init(VsyncClock* clock, double refresh_interval, bool simulated) {
+    clock->refresh_interval = refresh_interval;
+    clock->simulated = simulated;
+    clock->simulated_time = 0.0;
+    clock->start_time = chrono::steady_clock::now();
+    clock->last_vsync = 0.0;
+}
+
+double vsync_clock_now(const VsyncClock* clock) {
+    if (clock->simulated) {
+        return clock->simulated_time;
+    }
+    chrono::duration<double> elapsed_seconds = chrono::steady_clock::now() - clock->start_time;
+    return elapsed_seconds.count();
+}
+
+double vsync_clock_wait(VsyncClock* clock) {
+    if (clock->simulated) {
+        clock->simulated_time += clock->refresh_interval;
+        clock->last_vsync = clock->simulated_time;
+        return clock->last_vsync;
+    }
+
+    if (clock->swap) {
+        clock->swap();
+    }
+    if (!clock->vsync_enabled) {
+        // Sin vsync el swap no bloquea: esperar hasta el refresco previsto
+        double target = clock->last_vsync + clock->refresh_interval;
+        double now = vsync_clock_now(clock);
+        if (target > now) {
+            this_thread::sleep_for(chrono::duration<double>(target - now));
+        }
+    }
+    clock->last_vsync = vsync_clock_now(clock);
+    return clock->last_vsync;
+}
+
+void frame_scheduler_init(FrameScheduler* scheduler, double refresh_interval) {
+    scheduler->refresh_interval = refresh_interval;
+    scheduler->clock_origin = 0.0;
+    scheduler->clock_started = false;
+    scheduler->last_vsync = -1.0;
+    scheduler->has_current = false;
+    scheduler->current_refreshes = 0;
+    scheduler->has_previous = false;
+    scheduler->syncing = false;
+    bool record_present_errors = scheduler->stats.record_present_errors;
+    scheduler->stats = PresentStats();
+    scheduler->stats.record_present_errors = record_present_errors;
+}
+
+double frame_scheduler_next_vsync(const FrameScheduler* scheduler, double now) {
+    if (scheduler->last_vsync < 0.0) {
+        return now + scheduler->refresh_interval;
+    }
+    // Saltar los refrescos que ya han pasado
+    double next = scheduler->last_vsync + scheduler->refresh_interval;
+    if (next < now) {
+        next += ceil((now - next) / scheduler->refresh_interval) * scheduler->refresh_interval;
+    }
+    return next;
+}
+
+bool frame_scheduler_due(FrameScheduler* scheduler, double pts, double display_time) {
+    if (!scheduler->clock_started) {
+        // El primer frame fija la correspondencia entre PTS y tiempo de pantalla
+        scheduler->clock_origin = display_time - pts;
+        scheduler->clock_started = true;
+    }
+    double target = scheduler->clock_origin + pts;
+    return target <= display_time + scheduler->refresh_interval * 0.5 + DUE_EPSILON;
+}
+
+void frame_scheduler_advance(FrameScheduler* scheduler, double pts) {
+    // Cerrar las estadísticas del frame que se sustituye
+    frame_scheduler_finish(scheduler);
+    scheduler->has_current = true;
+    scheduler->current_pts = pts;
+    scheduler->current_refreshes = 0;
+}
+
+void frame_scheduler_presented(FrameScheduler* scheduler, double vsync_time) {
+    PresentStats& stats = scheduler->stats;
+
+    if (scheduler->last_vsync >= 0.0) {
+        double intervals = (vsync_time - scheduler->last_vsync) / scheduler->refresh_interval;
+        if (intervals > 1.5) {
+            stats.missed_refreshes += (int64_t)llround(intervals) - 1;
+        }
+    }
+    scheduler->last_vsync = vsync_time;
+
+    if (!scheduler->has_current) {
+        return;
+    }
+    stats.refreshes++;
+    scheduler->current_refreshes++;
+    if (scheduler->current_refreshes > 1) {
+        stats.duplicated_refreshes++;
+        return;
+    }
+
+    // Primera vez que este frame llega a pantalla
+    double error = vsync_time - (scheduler->clock_origin + scheduler->current_pts);
+    stats.frames_presented++;
+    stats.last_present_error = error;
+    stats.present_error_sum += error;
+    stats.present_error_max = max(stats.present_error_max, fabs(error));
+    if (stats.record_present_errors) {
+        stats.present_errors.push_back(error);
+    }
+
+    if (scheduler->has_previous) {
+        double jitter = (vsync_time - scheduler->previous_present_time) - (scheduler->current_pts - scheduler->previous_pts);
+        int bin = (int)lround(jitter / JITTER_BIN_WIDTH) + JITTER_HISTOGRAM_BINS / 2;
+        bin = min(max(bin, 0), JITTER_HISTOGRAM_BINS - 1);
+        stats.jitter_histogram[bin]++;
+    }
+    scheduler->has_previous = true;
+    scheduler->previous_pts = scheduler->current_pts;
+    scheduler->previous_present_time = vsync_time;
+}
+
+void frame_scheduler_sync(FrameScheduler* scheduler, double master_clock, double display_time) {
+    if (!scheduler->clock_started) {
+        return;
+    }
+    // Positivo: el video va adelantado respecto al reloj maestro
+    double drift = (display_time - scheduler->clock_origin) - master_clock;
+    if (fabs(drift) > scheduler->sync_max_drift) {
+        scheduler->syncing = false;
+        return;
+    }
+    if (!scheduler->syncing && fabs(drift) >= scheduler->sync_start_threshold) {
+        scheduler->syncing = true;
+    }
+    if (scheduler->syncing && fabs(drift) <= scheduler->sync_stop_threshold) {
+        scheduler->syncing = false;
+    }
+    if (scheduler->syncing) {
+        // Corrección gradual para no romper la cadencia con saltos bruscos
+        scheduler->clock_origin += drift * SYNC_GAIN;
+    }
+}
+
+void frame_scheduler_refresh(FrameScheduler* scheduler, VsyncClock* clock, FrameSource& source) {
+    double now = vsync_clock_now(clock);
+    double display_time = frame_scheduler_next_vsync(scheduler, now);
+
+    // Elegir el frame más reciente que debe estar en pantalla en el próximo refresco
+    double pts;
+    while (source.peek(pts) && frame_scheduler_due(scheduler, pts, display_time)) {
+        source.take(scheduler->has_current && scheduler->current_refreshes == 0);
+        frame_scheduler_advance(scheduler, pts);
+    }
+
+    if (scheduler->master_clock) {
+        double master_clock = scheduler->master_clock();
+        if (master_clock > 0.0) {
+            // Extrapolar el reloj maestro al instante en que se verá el frame
+            frame_scheduler_sync(scheduler, master_clock + (display_time - now), display_time);
+        }
+    }
+
+    if (scheduler->has_current) {
+        if (source.draw) source.draw();
+    } else if (source.clear) {
+        source.clear();
+    }
+    frame_scheduler_presented(scheduler, vsync_clock_wait(clock));
+}
+
+void frame_scheduler_finish(FrameScheduler* scheduler) {
+    PresentStats& stats = scheduler->stats;
+    if (scheduler->has_current) {
+        if (scheduler->current_refreshes == 0) {
+            stats.skipped_frames++;
+        } else {
+            int n = min(scheduler->current_refreshes, CADENCE_MAX_REFRESHES);
+            stats.cadence[n - 1]++;
+        }
+    }
+    scheduler->has_current = false;
+    scheduler->current_refreshes = 0;
+}
+
+void frame_scheduler_print_stats(const FrameScheduler* scheduler) {
+    const PresentStats& stats = scheduler->stats;
+    cout << "Refresh interval: " << scheduler->refresh_interval * 1000.0 << " ms" << endl;
+    cout << "Frames presented: " << stats.frames_presented
+         << ", refreshes: " << stats.refreshes
+         << ", duplicated: " << stats.duplicated_refreshes
+         << ", skipped frames: " << stats.skipped_frames
+         << ", missed refreshes: " << stats.missed_refreshes << endl;
+    cout << "Present error: mean " << stats.mean_present_error() * 1000.0
+         << " ms, max " << stats.present_error_max * 1000.0 << " ms" << endl;
+
+    cout << "Cadence (refreshes per frame):";
+    for (int i = 0; i < CADENCE_MAX_REFRESHES; i++) {
+        if (stats.cadence[i] > 0) {
+            cout << " " << i + 1 << (i + 1 == CADENCE_MAX_REFRESHES ? "+" : "") << "x" << stats.cadence[i];
+        }
+    }
+    cout << endl;
+
+    cout << "Jitter histogram (ms):" << endl;
+    for (int i = 0; i < JITTER_HISTOGRAM_BINS; i++) {
+        if (stats.jitter_histogram[i] > 0) {
+            int ms = i - JITTER_HISTOGRAM_BINS / 2;
+            const char* edge = (i == 0) ? "<=" : (i == JITTER_HISTOGRAM_BINS - 1) ? ">=" : "";
+            cout << "  " << edge << ms << ": " << stats.jitter_histogram[i] << endl;
+        }
+    }
+}
+
+bool frame_scheduler_simulate(FrameScheduler* scheduler, double frame_rate, double refresh_rate, double seconds) {
+    if (!(frame_rate > 0.0) || !(refresh_rate > 0.0) || !(seconds > 0.0)) {
+        return false;
+    }
+    VsyncClock clock;
+    frame_scheduler_init(scheduler, 1.0 / refresh_rate);
+    vsync_clock_init(&clock, 1.0 / refresh_rate, true);
+
+    int64_t total_frames = (int64_t)(frame_rate * seconds);
+    int64_t next_frame = 0;
+    FrameSource source;
+    source.peek = [&](double& pts) {
+        if (next_frame >= total_frames) return false;
+        pts = next_frame / frame_rate;
+        return true;
+    };
+    source.take = [&](bool) { next_frame++; };
+
+    while (next_frame < total_frames) {
+        frame_scheduler_refresh(scheduler, &clock, source);
+    }
+    // Mantener el último frame en pantalla hasta que termine su duración
+    double end_pts = total_frames / frame_rate;
+    while (scheduler->has_current && !frame_scheduler_due(scheduler, end_pts, frame_scheduler_next_vsync(scheduler, vsync_clock_now(&clock)))) {
+        frame_scheduler_refresh(scheduler, &clock, source);
+    }
+    frame_scheduler_finish(scheduler);
+    return true;
+}
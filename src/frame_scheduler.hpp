@@ -0,0 +1,124 @@
+#ifndef frame_scheduler_hpp
+#define frame_scheduler_hpp
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <inttypes.h>
+
+using namespace std;
+
+// Planificador de presentación: en cada refresco de pantalla decide qué frame
+// se muestra. Un frame pasa a pantalla en el primer refresco cuyo instante
+// supera su PTS menos medio intervalo, lo que produce de forma natural las
+// cadencias tipo 3:2 (24p a 60 Hz) o 2:2 (30p a 60 Hz).
+
+#define JITTER_HISTOGRAM_BINS 41     // Bins con signo centrados en 0
+#define JITTER_BIN_WIDTH 0.001       // 1 ms por bin
+#define CADENCE_MAX_REFRESHES 8      // Refrescos por frame contabilizados por separado
+
+struct PresentStats {
+    int64_t refreshes = 0;              // Refrescos con un frame en pantalla
+    int64_t frames_presented = 0;       // Frames distintos mostrados
+    int64_t duplicated_refreshes = 0;   // Refrescos que repiten el frame anterior
+    int64_t skipped_frames = 0;         // Frames sustituidos antes de llegar a mostrarse
+    int64_t missed_refreshes = 0;       // Refrescos perdidos (swap más lento que un intervalo)
+
+    // Error de presentación: instante real del refresco - instante ideal según el PTS
+    double last_present_error = 0.0;
+    double present_error_sum = 0.0;
+    double present_error_max = 0.0;     // Máximo en valor absoluto
+    bool record_present_errors = false;
+    vector<double> present_errors;      // Error por frame si record_present_errors
+
+    // Jitter: intervalo real entre frames consecutivos - diferencia de sus PTS
+    int64_t jitter_histogram[JITTER_HISTOGRAM_BINS] = {};
+    // cadence[n - 1]: frames que permanecieron n refrescos en pantalla
+    int64_t cadence[CADENCE_MAX_REFRESHES] = {};
+
+    double mean_present_error() const { return frames_presented > 0 ? present_error_sum / frames_presented : 0.0; }
+};
+
+struct FrameScheduler {
+    double refresh_interval;        // Segundos entre refrescos
+    double clock_origin = 0.0;      // Instante de pantalla que corresponde a PTS 0
+    bool clock_started = false;
+    double last_vsync = -1.0;
+
+    // Frame actualmente seleccionado
+    bool has_current = false;
+    double current_pts = 0.0;
+    int current_refreshes = 0;
+
+    // Último frame presentado, para el jitter
+    bool has_previous = false;
+    double previous_pts = 0.0;
+    double previous_present_time = 0.0;
+
+    // Sincronización con un reloj maestro opcional (segundos, <= 0 si aún no hay reloj).
+    // Con histéresis: se empieza a corregir al superar sync_start_threshold y se
+    // sigue hasta bajar de sync_stop_threshold. Derivas mayores que sync_max_drift se ignoran.
+    function<double()> master_clock;
+    double sync_start_threshold = 0.05;
+    double sync_stop_threshold = 0.01;
+    double sync_max_drift = 10.0;
+    bool syncing = false;
+
+    PresentStats stats;
+};
+
+// Reloj de vsync. En modo real wait() intercambia los buffers (swap bloqueante
+// con SDL_GL_SetSwapInterval(1)); si el vsync no está disponible duerme hasta el
+// siguiente refresco previsto. En modo simulado el tiempo avanza un intervalo
+// exacto por llamada, sin ventana ni esperas, para ejecuciones sin pantalla.
+struct VsyncClock {
+    double refresh_interval;
+    bool simulated = false;
+    bool vsync_enabled = false;
+    function<void()> swap;
+
+    double simulated_time = 0.0;
+    chrono::steady_clock::time_point start_time;
+    double last_vsync = 0.0;
+};
+
+// Origen de los frames para frame_scheduler_refresh.
+struct FrameSource {
+    // Devuelve el PTS en segundos del siguiente frame sin consumirlo, o false si no hay ninguno.
+    function<bool(double& pts)> peek;
+    // Convierte el siguiente frame en el actual. skipped: el actual no llegó a mostrarse.
+    function<void(bool skipped)> take;
+    // Dibuja el frame actual en el back buffer (opcional).
+    function<void()> draw;
+    // Limpia el back buffer mientras aún no hay ningún frame (opcional).
+    function<void()> clear;
+};
+
+void vsync_clock_init(VsyncClock* clock, double refresh_interval, bool simulated);
+double vsync_clock_now(const VsyncClock* clock);
+// Bloquea hasta el siguiente refresco y devuelve su instante en segundos.
+double vsync_clock_wait(VsyncClock* clock);
+
+void frame_scheduler_init(FrameScheduler* scheduler, double refresh_interval);
+// Instante previsto del próximo refresco posterior a now.
+double frame_scheduler_next_vsync(const FrameScheduler* scheduler, double now);
+// Indica si el frame con este PTS (segundos) debe estar en pantalla en display_time.
+bool frame_scheduler_due(FrameScheduler* scheduler, double pts, double display_time);
+// Selecciona el frame como actual; si el anterior no llegó a mostrarse cuenta como saltado.
+void frame_scheduler_advance(FrameScheduler* scheduler, double pts);
+// Registra que el frame actual se presentó en el refresco vsync_time.
+void frame_scheduler_presented(FrameScheduler* scheduler, double vsync_time);
+// Corrige gradualmente el origen hacia el reloj maestro (p.ej. el de audio).
+void frame_scheduler_sync(FrameScheduler* scheduler, double master_clock, double display_time);
+// Un refresco completo: selecciona el frame, sincroniza, dibuja y bloquea hasta el vsync.
+void frame_scheduler_refresh(FrameScheduler* scheduler, VsyncClock* clock, FrameSource& source);
+// Cierra las estadísticas del último frame al terminar la reproducción.
+void frame_scheduler_finish(FrameScheduler* scheduler);
+
+void frame_scheduler_print_stats(const FrameScheduler* scheduler);
+
+// Ejecuta frame_scheduler_refresh sin pantalla con frames a frame_rate sobre un vsync
+// simulado a refresh_rate. Devuelve false si algún parámetro no es positivo.
+bool frame_scheduler_simulate(FrameScheduler* scheduler, double frame_rate, double refresh_rate, double seconds);
+
+#endif
@@ -1,14 +1,19 @@
 #include <SDL3/SDL.h>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include "video_reader.hpp"
+#include "frame_scheduler.hpp"
 #include <GL/gl.h>
 #include <thread>
 #include <atomic>
 #include <mutex>
 
-#define AV_SYNC_THRESHOLD 0.01  // Umbral de sincronización en segundos (10 ms)
+#define AV_SYNC_THRESHOLD 0.01  // Umbral de sincronización en segundos (10 ms): la corrección sigue hasta bajar de él
 #define AV_NOSYNC_THRESHOLD 10.0 // Umbral para decidir no sincronizar (10 segundos)
+#define AV_RESYNC_THRESHOLD 0.05 // Deriva respecto al audio a partir de la cual se empieza a corregir el reloj de video
+#define DEFAULT_REFRESH_RATE 60.0
 
 using namespace std;
 
@@ -106,6 +111,20 @@ void monitor_queue_sizes(VideoState* state) {
 
 
 int main(int argc, const char** argv) {
+    // Modo sin pantalla: video-player --simulate-vsync <fps> <hz> [segundos]
+    if (argc >= 2 && strcmp(argv[1], "--simulate-vsync") == 0) {
+        FrameScheduler scheduler;
+        double frame_rate = argc >= 3 ? atof(argv[2]) : 0.0;
+        double refresh_rate = argc >= 4 ? atof(argv[3]) : 0.0;
+        double seconds = argc >= 5 ? atof(argv[4]) : 10.0;
+        if (!frame_scheduler_simulate(&scheduler, frame_rate, refresh_rate, seconds)) {
+            cout << "Usage: video-player --simulate-vsync <fps> <hz> [seconds] (all values > 0)" << endl;
+            return 1;
+        }
+        frame_scheduler_print_stats(&scheduler);
+        return 0;
+    }
+
     VideoState state;
 
     // Inicializar SDL
@@ -141,7 +160,19 @@ int main(int argc, const char** argv) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
-    //SDL_GL_SetSwapInterval(1);
+    // Sincronizar el swap con el refresco de pantalla
+    double refresh_rate = DEFAULT_REFRESH_RATE;
+    const SDL_DisplayMode* display_mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(state.window));
+    if (display_mode && display_mode->refresh_rate > 0.0f) {
+        refresh_rate = display_mode->refresh_rate;
+    }
+    VsyncClock vsync;
+    vsync_clock_init(&vsync, 1.0 / refresh_rate, false);
+    vsync.vsync_enabled = SDL_GL_SetSwapInterval(1) != SDL_FALSE;
+    if (!vsync.vsync_enabled) {
+        cout << "Couldn't enable vsync, pacing with timer: " << SDL_GetError() << endl;
+    }
+    vsync.swap = [&state]() { SDL_GL_SwapWindow(state.window); };
 
     // Abrir el archivo de video
     if (!video_reader_open(&state, "D:\\peliculas\\altered_carbon\\001.mp4")) {
@@ -186,44 +217,47 @@ int main(int argc, const char** argv) {
 		thread* log_thread = new thread(monitor_queue_sizes, &state);
 		SDL_Event event;
 
-		double pt_seconds;
-		VideoFrame vf;
-    while (!state.quit || !state.video_queue.empty()) {
+		FrameScheduler scheduler;
+		frame_scheduler_init(&scheduler, 1.0 / refresh_rate);
+		// Usar el reloj de audio como referencia
+		scheduler.master_clock = [&state]() { return (double)state.audio_clock; };
+		scheduler.sync_start_threshold = AV_RESYNC_THRESHOLD;
+		scheduler.sync_stop_threshold = AV_SYNC_THRESHOLD;
+		scheduler.sync_max_drift = AV_NOSYNC_THRESHOLD;
+
+		VideoFrame current;
+		VideoFrame next;
+		bool has_next = false;
+		FrameSource source;
+		source.peek = [&](double& pts) {
+				if (!has_next) has_next = state.video_queue.dequeue(next);
+				if (!has_next) return false;
+				pts = next.pts * av_q2d(state.video_time_base);
+				return true;
+		};
+		source.take = [&](bool skipped) {
+				if (skipped) {
+						cout << "Skipping frame, too late to display, PTS: " << current.pts << endl;
+				}
+				delete[] current.data;
+				current = next;
+				has_next = false;
+		};
+		source.draw = [&]() { draw_video_frame(&state, current); };
+		source.clear = []() { glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); };
+
+    while (!state.quit || !state.video_queue.empty() || has_next) {
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_EVENT_QUIT) {
                 state.quit = true;
             }
         }
-					if (state.video_queue.dequeue(vf)) {
-
-							double pt_seconds = vf.pts * (double)state.video_time_base.num / (double)state.video_time_base.den;
-							double master_clock = state.audio_clock;  // Usar el reloj de audio como referencia
-
-							// Sincronizar el cuadro de video con el reloj de audio
-							if (pt_seconds > master_clock) {
-									// Si el cuadro está adelantado, esperar el tiempo necesario
-									this_thread::sleep_for(chrono::milliseconds(static_cast<int>((pt_seconds - master_clock) * 1000)));
-							} else if (pt_seconds < master_clock - AV_SYNC_THRESHOLD) {
-									// Si el cuadro está retrasado y fuera del umbral de sincronización, se puede descartar
-									if (master_clock - pt_seconds > AV_NOSYNC_THRESHOLD) {
-											cout << "Skipping frame, too late to display, PTS: " << vf.pts << endl;
-											delete[] vf.data;
-											continue;  // Ir al siguiente cuadro sin renderizar este
-									}
-							}
-							render_video_frame(&state, vf);
-							cout << "Video frame played, PTS: " << vf.pts << endl;
-							pt_seconds = vf.pts * (double)state.video_time_base.num / (double)state.video_time_base.den;
-							// Sincronizar con el tiempo de reproducción.
-							/*Clock::time_point current_time = Clock::now();
-							chrono::duration<double> elapsed_seconds = current_time - start_time;
-							while (pt_seconds > elapsed_seconds.count()) {
-								current_time = Clock::now();
-								elapsed_seconds = current_time - start_time;
-							}*/
-							delete[] vf.data;
-					}
+        // El swap bloquea hasta el refresco: no hace falta dormir
+        frame_scheduler_refresh(&scheduler, &vsync, source);
     }
+    delete[] current.data;
+    frame_scheduler_finish(&scheduler);
+    frame_scheduler_print_stats(&scheduler);
 		cout << "End rendering video frames" << endl;
 
     if (state.decode_thread->joinable()) state.decode_thread->join();
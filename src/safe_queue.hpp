@@ -0,0 +1,66 @@
+#ifndef safe_queue_hpp
+#define safe_queue_hpp
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+using namespace std;
+
+template <typename T>
+class SafeQueue {
+private:
+    std::queue<T> q;
+    mutable std::mutex mtx;
+    std::condition_variable cv; // compartida por productores y consumidores: notificar a todos
+    size_t maxSize;
+		
+public:
+    SafeQueue(size_t maxSize) : maxSize(maxSize) {}
+
+    void enqueue(const T& item) {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return q.size() < maxSize; });
+        q.push(item);
+        cv.notify_all();
+    }
+
+    bool dequeue(T& item) {
+        unique_lock<mutex> lock(mtx);
+        if (q.empty()) return false;
+        item = q.front();
+        q.pop();
+        cv.notify_all();
+        return true;
+    }
+
+    void wait_dequeue(T& item) {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return !q.empty(); });
+        item = q.front();
+        q.pop();
+        cv.notify_all();
+    }
+
+    bool empty() {
+        lock_guard<mutex> lock(mtx);
+        return q.empty();
+    }
+
+    bool full() {
+        lock_guard<mutex> lock(mtx);
+        return q.size() >= maxSize;
+    }
+
+    void clear() {
+        lock_guard<mutex> lock(mtx);
+        while (!q.empty()) q.pop();
+    }
+
+		size_t size() const {
+			lock_guard<mutex> lock(mtx);
+			return q.size();
+    }
+};
+
+#endif
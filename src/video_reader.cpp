@@ -267,7 +267,7 @@ void decode_audio_packet(VideoState* state, AVPacket* packet, AudioData& ad) {
 }
 
 
-void render_video_frame(VideoState* state, const VideoFrame& vf) {
+void draw_video_frame(VideoState* state, const VideoFrame& vf) {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glViewport(0, 0, vf.width, vf.height);
     glMatrixMode(GL_PROJECTION);
@@ -287,6 +287,10 @@ void render_video_frame(VideoState* state, const VideoFrame& vf) {
     glTexCoord2d(0, 1); glVertex2i(0, vf.height);
     glEnd();
     glDisable(GL_TEXTURE_2D);
+}
+
+void render_video_frame(VideoState* state, const VideoFrame& vf) {
+    draw_video_frame(state, vf);
     SDL_GL_SwapWindow(state->window);
 }
 
@@ -1,12 +1,10 @@
 #ifndef video_reader_hpp
 #define video_reader_hpp
 
-#include <condition_variable>
 #include <iostream>
-#include <mutex>
-#include <queue>
 #include <thread>
 #include <atomic>
+#include "safe_queue.hpp"
 #include <GL/gl.h>
 extern "C" {
     #include <libavcodec/avcodec.h>
@@ -34,61 +32,6 @@ struct AudioData {
     double pts;
 };
 
-template <typename T>
-class SafeQueue {
-private:
-    std::queue<T> q;
-    mutable std::mutex mtx;
-    std::condition_variable cv;
-    size_t maxSize;
-		
-public:
-    SafeQueue(size_t maxSize) : maxSize(maxSize) {}
-
-    void enqueue(const T& item) {
-        unique_lock<mutex> lock(mtx);
-        cv.wait(lock, [this] { return q.size() < maxSize; });
-        q.push(item);
-        cv.notify_one();
-    }
-
-    bool dequeue(T& item) {
-        unique_lock<mutex> lock(mtx);
-        if (q.empty()) return false;
-        item = q.front();
-        q.pop();
-        cv.notify_one();
-        return true;
-    }
-
-    void wait_dequeue(T& item) {
-        unique_lock<mutex> lock(mtx);
-        cv.wait(lock, [this] { return !q.empty(); });
-        item = q.front();
-        q.pop();
-        cv.notify_one();
-    }
-
-    bool empty() {
-        lock_guard<mutex> lock(mtx);
-        return q.empty();
-    }
-
-    bool full() {
-        lock_guard<mutex> lock(mtx);
-        return q.size() >= maxSize;
-    }
-
-    void clear() {
-        lock_guard<mutex> lock(mtx);
-        while (!q.empty()) q.pop();
-    }
-
-		size_t size() const {
-			lock_guard<mutex> lock(mtx);
-			return q.size();
-    }
-};
 
 
 
@@ -142,6 +85,8 @@ void decode_video_packet(VideoState* state, AVPacket* packet, VideoFrame& vf);
 void decode_audio_packet(VideoState* state, AVPacket* packet, AudioData& ad);
 
 unsigned int video_refresh_timer(void* userdata, SDL_TimerID timerID, Uint32 interval);
+// Dibuja el frame sin intercambiar buffers; render_video_frame además hace el swap.
+void draw_video_frame(VideoState* state, const VideoFrame& vf);
 void render_video_frame(VideoState* state, const VideoFrame& vf);
 
 #endif